@@ -1,8 +1,16 @@
 ﻿#include <iostream>
 #include <string>
+#include <vector>
+#include <set>
+#include <utility>
+#include <random>
+#include <chrono>
 #include "polynomial.h"
+#include "polynomialcache.h"
+#include "multipolynomial.h"
 #include "texteditor.h"
 #include "uno.h"
+#include "instrumentation.h"
 
 using namespace std;
 
@@ -27,6 +35,156 @@ void testPolynomial() {
     cout << "Derivative of P1: " << derivative.toString() << endl;
 }
 
+//Print interning/cache counters
+static void printCacheStats(const string& label) {
+    polynomialcache::CacheStats s = polynomialcache::stats();
+    cout << label << ": hits=" << s.hits << ", misses=" << s.misses
+        << ", hitRate=" << s.hitRate() << ", entries=" << s.entries
+        << ", bytes=" << s.bytes << "/" << s.capacityBytes
+        << ", evictions=" << s.evictions << ", stores=" << s.internedStores << endl;
+}
+
+void testPolynomialCache() {
+    cout << "\n=== Polynomial Cache Test ===" << endl;
+
+    polynomialcache::clear();
+    polynomialcache::setEnabled(true);
+
+    Polynomial p1, p2;
+    p1.insertTerm(3, 2);   // 3x^2
+    p1.insertTerm(4, 1);   // +4x
+    p1.insertTerm(1, 0);   // +1
+    p2.insertTerm(5, 1);   // 5x
+    p2.insertTerm(-2, 0);  // -2
+
+    //Repeated work: only the first multiply/derivative is computed
+    for (int i = 0; i < 3; i++) {
+        Polynomial product = p1.multiply(p2);
+        Polynomial derivative = product.derivative();
+        cout << "Round " << i << ": Product: " << product.toString()
+            << ", Derivative: " << derivative.toString() << endl;
+    }
+    printCacheStats("After repeats");
+
+    //A separately built, identical polynomial interns to the same store and hits
+    Polynomial q1;
+    q1.insertTerm(1, 0);
+    q1.insertTerm(4, 1);
+    q1.insertTerm(3, 2);
+    Polynomial sameProduct = q1.multiply(p2);
+    cout << "Q1 * P2: " << sameProduct.toString() << endl;
+    printCacheStats("After identical operand");
+
+    //Copy on write: mutating an interned operand or cached result leaves other copies intact
+    Polynomial cached = p1.multiply(p2);
+    q1.insertTerm(7, 5);
+    cached.insertTerm(1, 0);
+    Polynomial again = p1.multiply(p2);
+    cout << "Mutated Q1: " << q1.toString() << ", P1 still: " << p1.toString() << endl;
+    cout << "Mutated result: " << cached.toString() << ", cached still: " << again.toString() << endl;
+
+    //Shrinking the capacity evicts least recently used entries
+    polynomialcache::setCapacityBytes(64);
+    printCacheStats("After shrinking capacity");
+
+    polynomialcache::setEnabled(false);
+    polynomialcache::setCapacityBytes(4 << 20);
+    printCacheStats("After disabling");
+}
+
+void testMultiPolynomial() {
+    cout << "\n=== Multivariate Polynomial Test ===" << endl;
+
+    MultiPolynomial p1(3), p2(3);
+    p1.insertTerm(3, { 2, 1, 0 });   // 3x1^2*x2
+    p1.insertTerm(-4, { 0, 0, 1 });  // -4x3
+    p2.insertTerm(5, { 1, 0, 0 });   // 5x1
+    p2.insertTerm(1, { 0, 0, 0 });   // +1
+
+    cout << "P1: " << p1.toString() << endl;
+    cout << "P2: " << p2.toString() << endl;
+
+    MultiPolynomial sum = p1.add(p2);
+    cout << "Sum: " << sum.toString() << endl;
+
+    MultiPolynomial product = p1.multiply(p2);
+    cout << "Product: " << product.toString() << endl;
+
+    MultiPolynomial dx1 = p1.derivative(0);
+    cout << "dP1/dx1: " << dx1.toString() << endl;
+}
+
+//Generate numTerms distinct random monomials (fixed seed) with non-zero coefficients
+//and exponents up to maxExp
+static vector<pair<int, vector<int>>> randomTerms(int numVars, int numTerms, int maxExp, mt19937& rng) {
+    uniform_int_distribution<int> coefDist(1, 9);
+    uniform_int_distribution<int> signDist(0, 1);
+    uniform_int_distribution<int> expDist(0, maxExp);
+    set<vector<int>> seen;
+    vector<pair<int, vector<int>>> terms;
+    vector<int> exps(numVars);
+    while ((int)terms.size() < numTerms) {
+        for (int v = 0; v < numVars; v++) exps[v] = expDist(rng);
+        if (!seen.insert(exps).second) continue;
+        int coef = coefDist(rng);
+        terms.push_back({ signDist(rng) ? coef : -coef, exps });
+    }
+    return terms;
+}
+
+static MultiPolynomial buildMultiPolynomial(int numVars, const vector<pair<int, vector<int>>>& terms) {
+    MultiPolynomial p(numVars);
+    for (auto& t : terms) p.insertTerm(t.first, t.second);
+    return p;
+}
+
+//Time insert/add/multiply/derivative on 10^5-term inputs with 4-8 variables
+void benchmarkMultiPolynomial() {
+    cout << "\n=== Multivariate Polynomial Benchmark ===" << endl;
+
+    const int numTerms = 100000;
+    for (int numVars = 4; numVars <= 8; numVars += 2) {
+        mt19937 rng(1234);
+        auto start = chrono::steady_clock::now();
+        auto elapsedMs = [&start]() {
+            auto now = chrono::steady_clock::now();
+            double ms = chrono::duration<double, milli>(now - start).count();
+            start = now;
+            return ms;
+        };
+
+        //16^4 monomials is too few for 10^5 distinct terms in 4 variables
+        int maxExp = (numVars <= 4) ? 63 : 15;
+        auto aTerms = randomTerms(numVars, numTerms, maxExp, rng);
+        auto bTerms = randomTerms(numVars, numTerms, maxExp, rng);
+        auto smallTerms = randomTerms(numVars, 100, maxExp, rng);
+        elapsedMs();
+
+        MultiPolynomial a = buildMultiPolynomial(numVars, aTerms);
+        MultiPolynomial b = buildMultiPolynomial(numVars, bTerms);
+        MultiPolynomial small = buildMultiPolynomial(numVars, smallTerms);
+        int aCount = a.getTermCount();
+        int bCount = b.getTermCount();
+        small.getTermCount();
+        double insertMs = elapsedMs();
+
+        MultiPolynomial sum = a.add(b);
+        double addMs = elapsedMs();
+
+        MultiPolynomial product = a.multiply(small);
+        double multiplyMs = elapsedMs();
+
+        MultiPolynomial deriv = a.derivative(numVars - 1);
+        double derivativeMs = elapsedMs();
+
+        cout << numVars << " variables: insert " << aCount << " + " << bCount << " terms " << insertMs << " ms"
+            << ", add " << addMs << " ms (" << sum.getTermCount() << " terms)"
+            << ", multiply by " << small.getTermCount() << " terms " << multiplyMs << " ms ("
+            << product.getTermCount() << " terms)"
+            << ", derivative " << derivativeMs << " ms" << endl;
+    }
+}
+
 void testTextEditor() {
     cout << "\n=== Text Editor Test ===" << endl;
 
@@ -65,9 +223,21 @@ void testUNOGame() {
     cout << "Winner is Player " << game.getWinner() << "!" << endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        benchmarkMultiPolynomial();
+        return 0;
+    }
+
     testPolynomial();
+    testPolynomialCache();
+    testMultiPolynomial();
     testTextEditor();
     testUNOGame();
+
+#ifdef DSA_INSTRUMENTATION
+    cout << "\n=== Instrumentation ===" << endl;
+    cout << instrumentation::dumpJSON() << endl;
+#endif
     return 0;
 }
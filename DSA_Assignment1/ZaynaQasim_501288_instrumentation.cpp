@@ -0,0 +1,288 @@
+﻿#include "instrumentation.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <mutex>
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+namespace instrumentation {
+
+static const int OpCount = (int)Op::Count;
+
+//Per-thread counters: written only by the owning thread, read by snapshot()
+struct ThreadStats {
+    atomic<uint64_t> calls[OpCount];
+    atomic<uint64_t> allocations[OpCount];
+    atomic<uint64_t> allocatedBytes[OpCount];
+    atomic<uint64_t> totalNanos[OpCount];
+    atomic<uint64_t> minNanos[OpCount];
+    atomic<uint64_t> maxNanos[OpCount];
+    atomic<uint64_t> histogram[OpCount][HistBuckets];
+    atomic<uint64_t> epoch;     //reset() generation these counters belong to
+
+    explicit ThreadStats(uint64_t e) { clear(); epoch.store(e, memory_order_relaxed); }
+
+    void clear() {
+        for (int i = 0; i < OpCount; i++) {
+            calls[i].store(0, memory_order_relaxed);
+            allocations[i].store(0, memory_order_relaxed);
+            allocatedBytes[i].store(0, memory_order_relaxed);
+            totalNanos[i].store(0, memory_order_relaxed);
+            minNanos[i].store(0, memory_order_relaxed);
+            maxNanos[i].store(0, memory_order_relaxed);
+            for (int b = 0; b < HistBuckets; b++) histogram[i][b].store(0, memory_order_relaxed);
+        }
+    }
+};
+
+//Calling thread's active operation; trivially initialized so operator new can read it
+static thread_local Op active = Op::Count;
+
+//Bumped by reset(); each thread clears its own counters when it sees a new value
+static atomic<uint64_t> resetEpoch(0);
+
+//Global registry of live threads' stats, plus the merged stats of exited threads
+static mutex registryMutex;
+static vector<ThreadStats*>& registry() {
+    static vector<ThreadStats*> threads;
+    return threads;
+}
+static vector<OpStats>& retired() {
+    static vector<OpStats> totals((int)Op::Count);
+    return totals;
+}
+
+//Add one thread's counters to per-op totals
+static void addThread(vector<OpStats>& result, const ThreadStats& stats) {
+    for (int i = 0; i < OpCount; i++) {
+        uint64_t calls = stats.calls[i].load(memory_order_relaxed);
+        OpStats& out = result[i];
+        out.allocations += stats.allocations[i].load(memory_order_relaxed);
+        out.allocatedBytes += stats.allocatedBytes[i].load(memory_order_relaxed);
+        if (calls == 0) continue;
+
+        uint64_t mn = stats.minNanos[i].load(memory_order_relaxed);
+        uint64_t mx = stats.maxNanos[i].load(memory_order_relaxed);
+        if (out.calls == 0 || mn < out.minNanos) out.minNanos = mn;
+        if (mx > out.maxNanos) out.maxNanos = mx;
+        out.calls += calls;
+        out.totalNanos += stats.totalNanos[i].load(memory_order_relaxed);
+        for (int b = 0; b < HistBuckets; b++)
+            out.histogram[b] += stats.histogram[i][b].load(memory_order_relaxed);
+    }
+}
+
+//Owns the calling thread's stats; on thread exit folds them into the retired totals
+struct LocalStats {
+    ThreadStats* stats = nullptr;
+    ~LocalStats() {
+        if (!stats) return;
+        lock_guard<mutex> lock(registryMutex);
+        if (stats->epoch.load(memory_order_acquire) == resetEpoch.load(memory_order_relaxed))
+            addThread(retired(), *stats);
+        vector<ThreadStats*>& threads = registry();
+        threads.erase(find(threads.begin(), threads.end(), stats));
+        delete stats;
+    }
+};
+
+//Get stats for the calling thread, registering them on first use and
+//discarding them if reset() ran since they were last written
+static ThreadStats& local() {
+    thread_local LocalStats handle;
+    if (!handle.stats) {
+        handle.stats = new ThreadStats(resetEpoch.load(memory_order_relaxed));
+        lock_guard<mutex> lock(registryMutex);
+        registry().push_back(handle.stats);
+    }
+    ThreadStats& stats = *handle.stats;
+    uint64_t current = resetEpoch.load(memory_order_relaxed);
+    if (stats.epoch.load(memory_order_relaxed) != current) {
+        stats.clear();
+        stats.epoch.store(current, memory_order_release);
+    }
+    return stats;
+}
+
+//Single-writer increment: no read-modify-write needed
+static void bump(atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+const char* opName(Op op) {
+    switch (op) {
+    case Op::PolyInsertTerm: return "Polynomial::insertTerm";
+    case Op::PolyToString: return "Polynomial::toString";
+    case Op::PolyAdd: return "Polynomial::add";
+    case Op::PolyMultiply: return "Polynomial::multiply";
+    case Op::PolyDerivative: return "Polynomial::derivative";
+    case Op::EditorInsertChar: return "TextEditor::insertChar";
+    case Op::EditorDeleteChar: return "TextEditor::deleteChar";
+    case Op::EditorMoveLeft: return "TextEditor::moveLeft";
+    case Op::EditorMoveRight: return "TextEditor::moveRight";
+    case Op::EditorGetTextWithCursor: return "TextEditor::getTextWithCursor";
+    case Op::UnoInitialize: return "UNOGame::initialize";
+    case Op::UnoPlayTurn: return "UNOGame::playTurn";
+    default: return "unknown";
+    }
+}
+
+//Values below HistSubBuckets get exact buckets, larger ones keep HistSubBits of mantissa
+int bucketFor(uint64_t nanos) {
+    if (nanos < (uint64_t)HistSubBuckets) return (int)nanos;
+    int msb = 0;
+    for (uint64_t v = nanos; v > 1; v >>= 1) msb++;
+    int shift = msb - HistSubBits;
+    return (shift + 1) * HistSubBuckets + (int)((nanos >> shift) - HistSubBuckets);
+}
+
+uint64_t bucketLowerBound(int bucket) {
+    if (bucket < HistSubBuckets) return (uint64_t)bucket;
+    int shift = bucket / HistSubBuckets - 1;
+    uint64_t mantissa = (uint64_t)(bucket % HistSubBuckets + HistSubBuckets);
+    return mantissa << shift;
+}
+
+uint64_t OpStats::percentile(double q) const {
+    if (calls == 0) return 0;
+    if (q < 0) q = 0;
+    if (q > 1) q = 1;
+    uint64_t rank = (uint64_t)ceil(q * (double)calls);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < HistBuckets; b++) {
+        seen += histogram[b];
+        if (seen >= rank) return min(maxNanos, max(minNanos, bucketLowerBound(b)));
+    }
+    return maxNanos;
+}
+
+Op enterScope(Op op) {
+    local(); //register before op is active, so registration is not charged to it
+    Op previous = active;
+    active = op;
+    return previous;
+}
+
+void leaveScope(Op op, Op previous, uint64_t nanos) {
+    ThreadStats& stats = local();
+    int i = (int)op;
+    uint64_t count = stats.calls[i].load(memory_order_relaxed);
+    if (count == 0 || nanos < stats.minNanos[i].load(memory_order_relaxed))
+        stats.minNanos[i].store(nanos, memory_order_relaxed);
+    if (nanos > stats.maxNanos[i].load(memory_order_relaxed))
+        stats.maxNanos[i].store(nanos, memory_order_relaxed);
+    bump(stats.totalNanos[i], nanos);
+    bump(stats.histogram[i][bucketFor(nanos)], 1);
+    stats.calls[i].store(count + 1, memory_order_relaxed);
+    active = previous;
+}
+
+vector<OpStats> snapshot() {
+    lock_guard<mutex> lock(registryMutex);
+    vector<OpStats> result = retired();
+    uint64_t current = resetEpoch.load(memory_order_relaxed);
+    for (ThreadStats* stats : registry()) {
+        //Threads that have not recorded since reset() still hold stale counters
+        if (stats->epoch.load(memory_order_acquire) != current) continue;
+        addThread(result, *stats);
+    }
+    return result;
+}
+
+void reset() {
+    lock_guard<mutex> lock(registryMutex);
+    resetEpoch.fetch_add(1, memory_order_relaxed);
+    retired().assign(OpCount, OpStats());
+}
+
+string dumpJSON() {
+    vector<OpStats> stats = snapshot();
+    ostringstream out;
+    out << "{";
+    bool first = true;
+    for (int i = 0; i < OpCount; i++) {
+        const OpStats& s = stats[i];
+        if (s.calls == 0 && s.allocations == 0) continue;
+
+        if (!first) out << ",";
+        first = false;
+        out << "\n  \"" << opName((Op)i) << "\": {"
+            << "\"calls\": " << s.calls
+            << ", \"allocations\": " << s.allocations
+            << ", \"allocatedBytes\": " << s.allocatedBytes
+            << ", \"totalNanos\": " << s.totalNanos
+            << ", \"minNanos\": " << s.minNanos
+            << ", \"maxNanos\": " << s.maxNanos
+            << ", \"p50Nanos\": " << s.percentile(0.50)
+            << ", \"p90Nanos\": " << s.percentile(0.90)
+            << ", \"p99Nanos\": " << s.percentile(0.99)
+            << ", \"p999Nanos\": " << s.percentile(0.999)
+            << ", \"histogram\": [";
+
+        //Only non-empty buckets, as [lowerBoundNanos, count] pairs
+        bool firstBucket = true;
+        for (int b = 0; b < HistBuckets; b++) {
+            if (s.histogram[b] == 0) continue;
+            if (!firstBucket) out << ", ";
+            firstBucket = false;
+            out << "[" << bucketLowerBound(b) << ", " << s.histogram[b] << "]";
+        }
+        out << "]}";
+    }
+    out << (first ? "}" : "\n}");
+    return out.str();
+}
+
+} // namespace instrumentation
+
+#ifdef DSA_INSTRUMENTATION
+//GCC flags free() on memory from operator new once these are inlined into this file
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace instrumentation {
+
+//Set while charging an allocation, so allocations made by the bookkeeping itself are skipped
+static thread_local bool inAllocHook = false;
+
+//Charge one allocation to the calling thread's active operation
+static void recordAlloc(size_t bytes) {
+    if (active == Op::Count || inAllocHook) return;
+    inAllocHook = true;
+    ThreadStats& stats = local();
+    int i = (int)active;
+    bump(stats.allocations[i], 1);
+    bump(stats.allocatedBytes[i], bytes);
+    inAllocHook = false;
+}
+
+} // namespace instrumentation
+
+//Replacement global allocation functions; the array and nothrow forms forward to these
+void* operator new(size_t size) {
+    if (size == 0) size = 1;
+    void* p;
+    //Standard retry loop: give any installed new-handler a chance to free memory
+    while (!(p = malloc(size))) {
+        new_handler handler = get_new_handler();
+        if (!handler) throw bad_alloc();
+        handler();
+    }
+    instrumentation::recordAlloc(size);
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+#endif
@@ -0,0 +1,328 @@
+﻿#include "multipolynomial.h"
+#include <map>
+#include <unordered_map>
+#include <queue>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+//One term: packed exponents and coefficient
+struct MultiTerm {
+    uint64_t mono;
+    int coef;
+};
+
+//Hidden polynomial state
+struct MultiImpl {
+    int numVars;
+    int bits;                   //bits per exponent field
+    uint64_t fieldMask;         //mask of one field (at shift 0)
+    uint64_t guardMask;         //top bit of every field, set only on exponent overflow
+    vector<MultiTerm> terms;    //sorted by mono descending, no zero coefficients
+    unordered_map<uint64_t, int> pending;  //combined coefficients of inserts not yet merged into terms
+};
+
+//Global storage for MultiPolynomial* with MultiImpl*
+static map<const MultiPolynomial*, MultiImpl*> multiStorage;
+
+//Retrieve internal storage safely
+static MultiImpl* getImpl(const MultiPolynomial* p) {
+    auto it = multiStorage.find(p);
+    if (it == multiStorage.end())
+        throw runtime_error("MultiPolynomial not initialized properly.");
+    return it->second;
+}
+
+//Shift of variable v's field; x1 is most significant so integer order is lex order
+static int fieldShift(const MultiImpl* impl, int v) {
+    return (impl->numVars - 1 - v) * impl->bits;
+}
+
+//Largest exponent a field can hold without touching its guard bit
+static int maxExponent(const MultiImpl* impl) {
+    return (int)((impl->fieldMask >> 1));
+}
+
+//Add coefficient to an accumulator, throwing if it would overflow a long long
+static void accumulate(long long& acc, long long value) {
+    if ((value > 0 && acc > numeric_limits<long long>::max() - value) ||
+        (value < 0 && acc < numeric_limits<long long>::min() - value)) {
+        throw overflow_error("Coefficient overflow");
+    }
+    acc += value;
+}
+
+static int toCoefficient(long long value) {
+    if (value > numeric_limits<int>::max() || value < numeric_limits<int>::min()) {
+        throw overflow_error("Coefficient overflow");
+    }
+    return (int)value;
+}
+
+//Coefficient of a monomial in the sorted term list (0 if absent)
+static int termCoefficient(const MultiImpl* impl, uint64_t mono) {
+    auto it = lower_bound(impl->terms.begin(), impl->terms.end(), mono,
+        [](const MultiTerm& t, uint64_t m) { return t.mono > m; });
+    return (it != impl->terms.end() && it->mono == mono) ? it->coef : 0;
+}
+
+//Merge pending inserts into the sorted term list; pending coefficients already
+//include the matching term's coefficient, so they replace it
+static void normalize(MultiImpl* impl) {
+    if (impl->pending.empty()) return;
+
+    vector<MultiTerm> pending;
+    pending.reserve(impl->pending.size());
+    for (auto& kv : impl->pending) pending.push_back({ kv.first, kv.second });
+    sort(pending.begin(), pending.end(),
+        [](const MultiTerm& a, const MultiTerm& b) { return a.mono > b.mono; });
+
+    vector<MultiTerm> merged;
+    merged.reserve(impl->terms.size() + pending.size());
+    size_t i = 0, j = 0;
+    while (i < impl->terms.size() || j < pending.size()) {
+        if (j == pending.size() || (i < impl->terms.size() && impl->terms[i].mono > pending[j].mono)) {
+            merged.push_back(impl->terms[i++]);
+        }
+        else {
+            if (i < impl->terms.size() && impl->terms[i].mono == pending[j].mono) i++;
+            if (pending[j].coef != 0) merged.push_back(pending[j]);
+            j++;
+        }
+    }
+
+    impl->terms.swap(merged);
+    impl->pending.clear();
+}
+
+//Get normalized storage for reading
+static MultiImpl* getTerms(const MultiPolynomial* p) {
+    MultiImpl* impl = getImpl(p);
+    normalize(impl);
+    return impl;
+}
+
+//Constructor
+MultiPolynomial::MultiPolynomial(int numVariables) {
+    if (numVariables < 1 || numVariables > 8)
+        throw invalid_argument("Variables must be between 1 and 8");
+
+    MultiImpl* impl = new MultiImpl();
+    impl->numVars = numVariables;
+    impl->bits = min(32, 64 / numVariables);
+    impl->fieldMask = (1ull << impl->bits) - 1;
+    impl->guardMask = 0;
+    for (int v = 0; v < numVariables; v++)
+        impl->guardMask |= (1ull << (impl->bits - 1)) << fieldShift(impl, v);
+
+    multiStorage[this] = impl;
+}
+
+//Copy constructor
+MultiPolynomial::MultiPolynomial(const MultiPolynomial& other) {
+    multiStorage[this] = new MultiImpl(*getImpl(&other));
+}
+
+//Copy assignment
+MultiPolynomial& MultiPolynomial::operator=(const MultiPolynomial& other) {
+    if (this != &other) *getImpl(this) = *getImpl(&other);
+    return *this;
+}
+
+//Destructor: release storage
+MultiPolynomial::~MultiPolynomial() {
+    auto it = multiStorage.find(this);
+    if (it != multiStorage.end()) {
+        delete it->second;
+        multiStorage.erase(it);
+    }
+}
+
+//Insert term into polynomial
+void MultiPolynomial::insertTerm(int coefficient, const vector<int>& exponents) {
+    MultiImpl* impl = getImpl(this);
+    if ((int)exponents.size() != impl->numVars)
+        throw invalid_argument("Exponent count must match number of variables");
+
+    uint64_t mono = 0;
+    for (int v = 0; v < impl->numVars; v++) {
+        if (exponents[v] < 0) throw invalid_argument("Exponent must be non-negative");
+        if (exponents[v] > maxExponent(impl)) throw overflow_error("Exponent too large");
+        mono |= (uint64_t)exponents[v] << fieldShift(impl, v);
+    }
+    if (coefficient == 0) return;
+
+    //Appending below the smallest term keeps the list sorted without a merge
+    if (impl->pending.empty() && (impl->terms.empty() || impl->terms.back().mono > mono)) {
+        impl->terms.push_back({ mono, coefficient });
+        return;
+    }
+
+    //Combine with any existing coefficient now so overflow is rejected here, not on a later read
+    auto it = impl->pending.find(mono);
+    long long current = (it != impl->pending.end()) ? it->second : termCoefficient(impl, mono);
+    int combined = toCoefficient(current + coefficient);
+    if (it != impl->pending.end()) it->second = combined;
+    else impl->pending.emplace(mono, combined);
+}
+
+//Convert polynomial to string
+string MultiPolynomial::toString() const {
+    MultiImpl* impl = getTerms(this);
+    if (impl->terms.empty()) return "0";
+
+    ostringstream oss;
+    bool first = true;
+    for (const MultiTerm& t : impl->terms) {
+        if (!first) {
+            oss << (t.coef > 0 ? " + " : " - ");
+        }
+        else if (t.coef < 0) {
+            oss << "-";
+        }
+
+        int absCoef = abs(t.coef);
+        bool constant = (t.mono == 0);
+        if (absCoef != 1 || constant) oss << absCoef;
+
+        bool firstVar = true;
+        for (int v = 0; v < impl->numVars; v++) {
+            int e = (int)((t.mono >> fieldShift(impl, v)) & impl->fieldMask);
+            if (e == 0) continue;
+            if (!firstVar) oss << "*";
+            oss << "x" << (v + 1);
+            if (e > 1) oss << "^" << e;
+            firstVar = false;
+        }
+
+        first = false;
+    }
+    return oss.str();
+}
+
+//Add two polynomials (merge of two sorted lists)
+MultiPolynomial MultiPolynomial::add(const MultiPolynomial& other) const {
+    MultiImpl* a = getTerms(this);
+    MultiImpl* b = getTerms(&other);
+    if (a->numVars != b->numVars)
+        throw invalid_argument("Polynomials must have the same number of variables");
+
+    MultiPolynomial result(a->numVars);
+    vector<MultiTerm>& out = getImpl(&result)->terms;
+    out.reserve(a->terms.size() + b->terms.size());
+
+    size_t i = 0, j = 0;
+    while (i < a->terms.size() || j < b->terms.size()) {
+        if (j == b->terms.size() || (i < a->terms.size() && a->terms[i].mono > b->terms[j].mono)) {
+            out.push_back(a->terms[i++]);
+        }
+        else if (i == a->terms.size() || b->terms[j].mono > a->terms[i].mono) {
+            out.push_back(b->terms[j++]);
+        }
+        else {
+            long long coef = (long long)a->terms[i].coef + b->terms[j].coef;
+            if (coef != 0) out.push_back({ a->terms[i].mono, toCoefficient(coef) });
+            i++;
+            j++;
+        }
+    }
+
+    return result;
+}
+
+//Heap entry for multiplication: product of small[row] and big[col]
+struct HeapEntry {
+    uint64_t mono;
+    size_t row;
+    size_t col;
+    bool operator<(const HeapEntry& other) const { return mono < other.mono; }
+};
+
+//Multiply two polynomials using a heap of one cursor per term of the smaller operand,
+//so products come out already sorted and like terms are combined as they appear
+MultiPolynomial MultiPolynomial::multiply(const MultiPolynomial& other) const {
+    MultiImpl* a = getTerms(this);
+    MultiImpl* b = getTerms(&other);
+    if (a->numVars != b->numVars)
+        throw invalid_argument("Polynomials must have the same number of variables");
+
+    MultiPolynomial result(a->numVars);
+    const vector<MultiTerm>& small = (a->terms.size() <= b->terms.size()) ? a->terms : b->terms;
+    const vector<MultiTerm>& big = (a->terms.size() <= b->terms.size()) ? b->terms : a->terms;
+    if (small.empty()) return result;
+
+    vector<HeapEntry> storage;
+    storage.reserve(small.size());
+    for (size_t r = 0; r < small.size(); r++) storage.push_back({ small[r].mono + big[0].mono, r, 0 });
+    priority_queue<HeapEntry> heap(less<HeapEntry>(), move(storage));
+
+    vector<MultiTerm>& out = getImpl(&result)->terms;
+    uint64_t guard = a->guardMask;
+    bool haveCurrent = false;
+    uint64_t currentMono = 0;
+    long long currentCoef = 0;
+
+    while (!heap.empty()) {
+        HeapEntry top = heap.top();
+        heap.pop();
+
+        //Fields never carry into each other, so a set guard bit means exponent overflow
+        if (top.mono & guard) throw overflow_error("Exponent overflow in multiplication");
+
+        long long prod = (long long)small[top.row].coef * big[top.col].coef;
+        if (haveCurrent && top.mono == currentMono) {
+            accumulate(currentCoef, prod);
+        }
+        else {
+            if (haveCurrent && currentCoef != 0) out.push_back({ currentMono, toCoefficient(currentCoef) });
+            haveCurrent = true;
+            currentMono = top.mono;
+            currentCoef = prod;
+        }
+
+        if (top.col + 1 < big.size()) {
+            heap.push({ small[top.row].mono + big[top.col + 1].mono, top.row, top.col + 1 });
+        }
+    }
+    if (haveCurrent && currentCoef != 0) out.push_back({ currentMono, toCoefficient(currentCoef) });
+
+    return result;
+}
+
+//Partial derivative; decrementing one field keeps the remaining terms in order
+MultiPolynomial MultiPolynomial::derivative(int variable) const {
+    MultiImpl* impl = getTerms(this);
+    if (variable < 0 || variable >= impl->numVars)
+        throw invalid_argument("Variable index out of range");
+
+    MultiPolynomial result(impl->numVars);
+    vector<MultiTerm>& out = getImpl(&result)->terms;
+    int shift = fieldShift(impl, variable);
+
+    for (const MultiTerm& t : impl->terms) {
+        int e = (int)((t.mono >> shift) & impl->fieldMask);
+        if (e == 0) continue;
+        long long prod = (long long)t.coef * e;
+        out.push_back({ t.mono - (1ull << shift), toCoefficient(prod) });
+    }
+    return result;
+}
+
+//Return number of variables
+int MultiPolynomial::getNumVariables() const {
+    return getImpl(this)->numVars;
+}
+
+//Return number of non-zero terms
+int MultiPolynomial::getTermCount() const {
+    return (int)getTerms(this)->terms.size();
+}
@@ -1,5 +1,12 @@
 ﻿#include "polynomial.h"
+#include "instrumentation.h"
+#include "polynomialcache.h"
 #include <map>
+#include <list>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
 #include <sstream>
 #include <stdexcept>
 #include <iostream>
@@ -90,15 +97,258 @@ static void insertNode(Node*& head, int coef, int exp) {
     }
 }
 
+//Shared, immutable term list used by the interning layer
+struct InternedStore {
+    Node* head;
+    size_t hash;
+    size_t terms;
+    int refs;   //polynomials and cache entries referencing this store
+};
+
+//Intern table: content hash -> stores with that hash
+static unordered_map<size_t, vector<InternedStore*>> internTable;
+
+//Head pointer of every shared list -> its store
+static unordered_map<const Node*, InternedStore*> sharedLists;
+
+//Return store owning a shared list, or nullptr if the list is privately owned
+static InternedStore* sharedStore(const Node* head) {
+    if (!head) return nullptr;
+    auto it = sharedLists.find(head);
+    return it == sharedLists.end() ? nullptr : it->second;
+}
+
+//Hash of a term list's contents
+static size_t hashList(const Node* head) {
+    size_t h = 14695981039346656037ull;
+    for (const Node* curr = head; curr; curr = curr->next) {
+        h ^= hash<long long>()(((long long)curr->exp << 32) ^ (unsigned int)curr->coef) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+//Check two term lists for equal contents
+static bool equalLists(const Node* a, const Node* b) {
+    while (a && b) {
+        if (a->coef != b->coef || a->exp != b->exp) return false;
+        a = a->next;
+        b = b->next;
+    }
+    return !a && !b;
+}
+
+//Drop one reference to a store, freeing it once unused
+static void releaseStore(InternedStore* store) {
+    if (--store->refs > 0) return;
+    vector<InternedStore*>& bucket = internTable[store->hash];
+    bucket.erase(find(bucket.begin(), bucket.end(), store));
+    if (bucket.empty()) internTable.erase(store->hash);
+    sharedLists.erase(store->head);
+    deleteList(store->head);
+    delete store;
+}
+
+//Release a polynomial's list, whether shared or privately owned
+static void releaseList(Node*& head) {
+    InternedStore* store = sharedStore(head);
+    if (store) {
+        releaseStore(store);
+        head = nullptr;
+    }
+    else deleteList(head);
+}
+
+//Replace a polynomial's list with the canonical shared store for its contents
+static InternedStore* intern(const Polynomial* p) {
+    Node*& head = getHead(p);
+    if (!head) return nullptr;
+    InternedStore* store = sharedStore(head);
+    if (store) return store;
+
+    size_t h = hashList(head);
+    vector<InternedStore*>& bucket = internTable[h];
+    for (InternedStore* candidate : bucket) {
+        if (equalLists(candidate->head, head)) {
+            deleteList(head);
+            head = candidate->head;
+            candidate->refs++;
+            return candidate;
+        }
+    }
+
+    size_t terms = 0;
+    for (Node* curr = head; curr; curr = curr->next) terms++;
+    store = new InternedStore{ head, h, terms, 1 };
+    bucket.push_back(store);
+    sharedLists[head] = store;
+    return store;
+}
+
+//Memoized operations
+enum class CachedOp { Add, Multiply, Derivative };
+
+//Cache key: operation and operand stores (nullptr for the zero polynomial / no operand)
+struct CacheKey {
+    CachedOp op;
+    InternedStore* lhs;
+    InternedStore* rhs;
+    bool operator==(const CacheKey& other) const {
+        return op == other.op && lhs == other.lhs && rhs == other.rhs;
+    }
+};
+
+struct CacheKeyHash {
+    size_t operator()(const CacheKey& k) const {
+        size_t h = hash<const void*>()(k.lhs);
+        h ^= hash<const void*>()(k.rhs) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        return h ^ ((size_t)k.op * 0x9e3779b97f4a7c15ull);
+    }
+};
+
+struct CacheEntry {
+    CacheKey key;
+    InternedStore* result;
+    size_t bytes;
+};
+
+//LRU cache: most recently used entries at the front
+static bool cacheEnabled = false;
+static size_t cacheCapacity = 4 << 20;
+static size_t cacheBytes = 0;
+static list<CacheEntry> cacheOrder;
+static unordered_map<CacheKey, list<CacheEntry>::iterator, CacheKeyHash> cacheIndex;
+static polynomialcache::CacheStats cacheCounters;
+
+//Term storage of a store in bytes
+static size_t storeBytes(const InternedStore* store) {
+    return store ? store->terms * sizeof(Node) : 0;
+}
+
+//Release the stores held by a cache entry
+static void releaseEntry(CacheEntry& entry) {
+    if (entry.key.lhs) releaseStore(entry.key.lhs);
+    if (entry.key.rhs) releaseStore(entry.key.rhs);
+    if (entry.result) releaseStore(entry.result);
+    cacheBytes -= entry.bytes;
+}
+
+//Evict least recently used entries until within capacity
+static void evictToCapacity() {
+    while (cacheBytes > cacheCapacity && !cacheOrder.empty()) {
+        CacheEntry& last = cacheOrder.back();
+        cacheIndex.erase(last.key);
+        releaseEntry(last);
+        cacheOrder.pop_back();
+        cacheCounters.evictions++;
+    }
+}
+
+//Detach a new result from any list left at its address by a destroyed polynomial,
+//so computing it never writes into a stale (possibly shared) list
+static void resetResult(const Polynomial* result) {
+    releaseList(getHead(result));
+}
+
+//Look up a cached result; on a hit, make result share it
+static bool lookupCached(CachedOp op, const Polynomial* lhs, const Polynomial* rhs, CacheKey& key, const Polynomial* result) {
+    key = { op, intern(lhs), rhs ? intern(rhs) : nullptr };
+    auto it = cacheIndex.find(key);
+    if (it == cacheIndex.end()) {
+        cacheCounters.misses++;
+        return false;
+    }
+
+    cacheCounters.hits++;
+    cacheOrder.splice(cacheOrder.begin(), cacheOrder, it->second);
+    InternedStore* store = it->second->result;
+    if (store) {
+        store->refs++;
+        getHead(result) = store->head;
+    }
+    return true;
+}
+
+//Intern a freshly computed result and remember it under key
+static void storeCached(const CacheKey& key, const Polynomial* result) {
+    InternedStore* store = intern(result);
+    if (key.lhs) key.lhs->refs++;
+    if (key.rhs) key.rhs->refs++;
+    if (store) store->refs++;
+
+    //Charge the entry for every store it keeps alive, operands included, so the
+    //capacity bounds all term storage the cache pins (shared stores are over-counted)
+    size_t bytes = storeBytes(key.lhs);
+    if (key.rhs != key.lhs) bytes += storeBytes(key.rhs);
+    if (store != key.lhs && store != key.rhs) bytes += storeBytes(store);
+    cacheOrder.push_front({ key, store, bytes });
+    cacheIndex[key] = cacheOrder.begin();
+    cacheBytes += bytes;
+    evictToCapacity();
+}
+
+//Drop every cache entry
+static void clearCache() {
+    for (CacheEntry& entry : cacheOrder) releaseEntry(entry);
+    cacheOrder.clear();
+    cacheIndex.clear();
+}
+
+namespace polynomialcache {
+
+double CacheStats::hitRate() const {
+    uint64_t lookups = hits + misses;
+    return lookups == 0 ? 0.0 : (double)hits / (double)lookups;
+}
+
+void setEnabled(bool enabled) {
+    if (!enabled) clearCache();
+    cacheEnabled = enabled;
+}
+
+bool isEnabled() {
+    return cacheEnabled;
+}
+
+void setCapacityBytes(size_t bytes) {
+    cacheCapacity = bytes;
+    evictToCapacity();
+}
+
+CacheStats stats() {
+    CacheStats s = cacheCounters;
+    s.entries = cacheOrder.size();
+    s.bytes = cacheBytes;
+    s.capacityBytes = cacheCapacity;
+    s.internedStores = sharedLists.size();
+    return s;
+}
+
+void clear() {
+    clearCache();
+    cacheCounters = CacheStats();
+}
+
+} // namespace polynomialcache
+
 //Insert term into polynomial
 void Polynomial::insertTerm(int coefficient, int exponent) {
+    DSA_INSTR_SCOPE(PolyInsertTerm);
     if (exponent < 0) throw invalid_argument("Exponent must be non-negative");
     if (coefficient == 0) return;
-    insertNode(getHead(this), coefficient, exponent);
+
+    //Copy on write if the list is shared
+    Node*& head = getHead(this);
+    if (sharedStore(head)) {
+        Node* copy = copyList(head);
+        releaseList(head);
+        head = copy;
+    }
+    insertNode(head, coefficient, exponent);
 }
 
 //Convert polynomial to string
 string Polynomial::toString() const {
+    DSA_INSTR_SCOPE(PolyToString);
     Node* head = getHead(this);
     if (!head) return "0";
 
@@ -127,7 +377,12 @@ string Polynomial::toString() const {
 
 //Add two polynomials
 Polynomial Polynomial::add(const Polynomial& other) const {
+    DSA_INSTR_SCOPE(PolyAdd);
     Polynomial result;
+    resetResult(&result);
+    CacheKey key;
+    if (cacheEnabled && lookupCached(CachedOp::Add, this, &other, key, &result)) return result;
+
     Node* head1 = getHead(this);
     Node* head2 = getHead(&other);
 
@@ -143,12 +398,18 @@ Polynomial Polynomial::add(const Polynomial& other) const {
         curr = curr->next;
     }
 
+    if (cacheEnabled) storeCached(key, &result);
     return result;
 }
 
 //Multiply two polynomials
 Polynomial Polynomial::multiply(const Polynomial& other) const {
+    DSA_INSTR_SCOPE(PolyMultiply);
     Polynomial result;
+    resetResult(&result);
+    CacheKey key;
+    if (cacheEnabled && lookupCached(CachedOp::Multiply, this, &other, key, &result)) return result;
+
     Node* head1 = getHead(this);
     Node* head2 = getHead(&other);
 
@@ -162,12 +423,18 @@ Polynomial Polynomial::multiply(const Polynomial& other) const {
         }
     }
 
+    if (cacheEnabled) storeCached(key, &result);
     return result;
 }
 
 //Derivative of polynomial
 Polynomial Polynomial::derivative() const {
+    DSA_INSTR_SCOPE(PolyDerivative);
     Polynomial result;
+    resetResult(&result);
+    CacheKey key;
+    if (cacheEnabled && lookupCached(CachedOp::Derivative, this, nullptr, key, &result)) return result;
+
     Node* head = getHead(this);
     for (Node* curr = head; curr; curr = curr->next) {
         if (curr->exp != 0) {
@@ -178,13 +445,15 @@ Polynomial Polynomial::derivative() const {
             insertNode(getHead(&result), (int)prod, curr->exp - 1);
         }
     }
+    if (cacheEnabled) storeCached(key, &result);
     return result;
 }
 
 //Cleanup global map
 void cleanupPolynomials() {
+    clearCache();
     for (auto& kv : polynomialData) {
-        deleteList(kv.second);
+        releaseList(kv.second);
     }
     polynomialData.clear();
 }
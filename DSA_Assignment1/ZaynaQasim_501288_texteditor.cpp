@@ -1,4 +1,5 @@
 ﻿#include "texteditor.h"
+#include "instrumentation.h"
 #include <stack>
 #include <map>
 #include <string>
@@ -24,18 +25,21 @@ static EditorImpl* getStorage(const TextEditor* ed) {
 
 //Insert printable ASCII character at cursor
 void TextEditor::insertChar(char c) {
+    DSA_INSTR_SCOPE(EditorInsertChar);
     if (c < 32 || c > 126) throw invalid_argument("Only printable ASCII allowed");
     getStorage(this)->left.push(c);
 }
 
 //Delete character before cursor
 void TextEditor::deleteChar() {
+    DSA_INSTR_SCOPE(EditorDeleteChar);
     stack<char>& l = getStorage(this)->left;
     if (!l.empty()) l.pop();
 }
 
 //Move cursor left
 void TextEditor::moveLeft() {
+    DSA_INSTR_SCOPE(EditorMoveLeft);
     EditorImpl* impl = getStorage(this);
     if (!impl->left.empty()) {
         impl->right.push(impl->left.top());
@@ -45,6 +49,7 @@ void TextEditor::moveLeft() {
 
 //Move cursor right
 void TextEditor::moveRight() {
+    DSA_INSTR_SCOPE(EditorMoveRight);
     EditorImpl* impl = getStorage(this);
     if (!impl->right.empty()) {
         impl->left.push(impl->right.top());
@@ -54,6 +59,7 @@ void TextEditor::moveRight() {
 
 //Get text with cursor position '|'
 string TextEditor::getTextWithCursor() const {
+    DSA_INSTR_SCOPE(EditorGetTextWithCursor);
     EditorImpl* impl = getStorage(this);
 
     //Build left string in correct order
@@ -1,4 +1,5 @@
 ﻿#include "uno.h"
+#include "instrumentation.h"
 #include <stack>
 #include <vector>
 #include <string>
@@ -7,6 +8,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 
 using namespace std;
 
@@ -96,6 +98,7 @@ UNOGame::UNOGame(int numPlayers) {
 
 //Initialize game: build, shuffle, and deal deck
 void UNOGame::initialize() {
+    DSA_INSTR_SCOPE(UnoInitialize);
     UNOImpl* impl = getImpl(this);
 
     //Clear previous state
@@ -192,6 +195,7 @@ static int nextPlayerIndex(const UNOImpl* impl, int start, int skipCount = 0) {
 
 //Play a turn
 void UNOGame::playTurn() {
+    DSA_INSTR_SCOPE(UnoPlayTurn);
     UNOImpl* impl = getImpl(this);
     if (isGameOver()) return;
 
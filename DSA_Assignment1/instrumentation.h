@@ -0,0 +1,106 @@
+#pragma once
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Opt-in hot-path instrumentation for Polynomial, TextEditor and UNOGame.
+// Define DSA_INSTRUMENTATION (e.g. /D DSA_INSTRUMENTATION or -DDSA_INSTRUMENTATION)
+// to compile it in; otherwise the DSA_INSTR_SCOPE hook expands to nothing.
+// When enabled, global operator new is replaced so every allocation made inside an
+// instrumented operation is charged to it.
+
+namespace instrumentation {
+
+// Instrumented operations
+enum class Op : int {
+    PolyInsertTerm,
+    PolyToString,
+    PolyAdd,
+    PolyMultiply,
+    PolyDerivative,
+    EditorInsertChar,
+    EditorDeleteChar,
+    EditorMoveLeft,
+    EditorMoveRight,
+    EditorGetTextWithCursor,
+    UnoInitialize,
+    UnoPlayTurn,
+    Count  // also means "no active operation"
+};
+
+// Log-linear latency histogram: 2^SubBits sub-buckets per power of two (nanoseconds)
+const int HistSubBits = 3;
+const int HistSubBuckets = 1 << HistSubBits;
+const int HistBuckets = (64 - HistSubBits + 1) * HistSubBuckets;
+
+// Aggregated stats for one operation
+struct OpStats {
+    std::uint64_t calls = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t allocatedBytes = 0;
+    std::uint64_t totalNanos = 0;
+    std::uint64_t minNanos = 0;
+    std::uint64_t maxNanos = 0;
+    std::vector<std::uint64_t> histogram = std::vector<std::uint64_t>(HistBuckets, 0);
+
+    // Approximate latency (ns) at quantile q in [0, 1]
+    std::uint64_t percentile(double q) const;
+};
+
+// Name used for an operation in snapshots and JSON output
+const char* opName(Op op);
+
+// Bucket index for a latency and the lower bound of a bucket
+int bucketFor(std::uint64_t nanos);
+std::uint64_t bucketLowerBound(int bucket);
+
+// Make op the calling thread's active operation and return the previous one
+Op enterScope(Op op);
+
+// Record one completed call and restore the previous active operation
+void leaveScope(Op op, Op previous, std::uint64_t nanos);
+
+// Merge the stats of all threads (indexed by Op)
+std::vector<OpStats> snapshot();
+
+// Clear the stats of all threads. Safe while other threads are recording: each
+// thread discards its own counters the next time it records
+void reset();
+
+// Snapshot as a JSON object keyed by operation name
+std::string dumpJSON();
+
+// Times the enclosing scope and records it against an operation
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Op op) : op(op), previous(enterScope(op)), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        leaveScope(op, previous, (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Op op;
+    Op previous;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace instrumentation
+
+#ifdef DSA_INSTRUMENTATION
+#define DSA_INSTR_CONCAT_(a, b) a##b
+#define DSA_INSTR_CONCAT(a, b) DSA_INSTR_CONCAT_(a, b)
+#define DSA_INSTR_SCOPE(op) \
+    ::instrumentation::ScopedTimer DSA_INSTR_CONCAT(dsaInstrTimer_, __LINE__)(::instrumentation::Op::op)
+#else
+#define DSA_INSTR_SCOPE(op) ((void)0)
+#endif
+
+#endif
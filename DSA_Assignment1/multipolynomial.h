@@ -0,0 +1,44 @@
+#pragma once
+#ifndef MULTIPOLYNOMIAL_H
+#define MULTIPOLYNOMIAL_H
+
+#include <string>
+#include <vector>
+
+// Sparse polynomial in 1-8 variables x1..xn. Each monomial's exponents are packed
+// into one 64-bit word, so comparing and multiplying monomials is a single integer
+// compare / add. Each exponent gets min(32, 64/n) bits, one of them a guard bit, so
+// the limit is 2^(min(32, 64/n) - 1) - 1: INT_MAX for 1-2 variables, 127 for 8.
+class MultiPolynomial {
+public:
+    // Create the zero polynomial in numVariables variables
+    explicit MultiPolynomial(int numVariables);
+
+    MultiPolynomial(const MultiPolynomial& other);
+    MultiPolynomial& operator=(const MultiPolynomial& other);
+    virtual ~MultiPolynomial();
+
+    // Insert a term; exponents[i] is the power of x(i+1). Like terms are combined
+    // and overflow-checked immediately; re-sorting is deferred to the next read
+    virtual void insertTerm(int coefficient, const std::vector<int>& exponents);
+
+    // Return polynomial as a human-readable string
+    virtual std::string toString() const;
+
+    // Return a new polynomial that is the sum of this and other
+    virtual MultiPolynomial add(const MultiPolynomial& other) const;
+
+    // Return a new polynomial that is the product of this and other
+    virtual MultiPolynomial multiply(const MultiPolynomial& other) const;
+
+    // Return a new polynomial that is the partial derivative with respect to x(variable+1)
+    virtual MultiPolynomial derivative(int variable) const;
+
+    // Return number of variables
+    virtual int getNumVariables() const;
+
+    // Return number of non-zero terms
+    virtual int getTermCount() const;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef POLYNOMIALCACHE_H
+#define POLYNOMIALCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Optional interning layer for Polynomial. When enabled, structurally identical
+// polynomials share one immutable, content-hashed term store (copied on write by
+// insertTerm), and add/multiply/derivative results are memoized in a bounded LRU
+// cache keyed on the operation and its operands' stores.
+
+namespace polynomialcache {
+
+// Cache and intern-table counters
+struct CacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t entries = 0;
+    std::size_t bytes = 0;          // term storage pinned by cache entries (operands and results)
+    std::size_t capacityBytes = 0;
+    std::size_t internedStores = 0;
+
+    // Fraction of lookups served from the cache
+    double hitRate() const;
+};
+
+// Turn interning and memoization on or off (off by default; turning off clears the cache)
+void setEnabled(bool enabled);
+bool isEnabled();
+
+// Cap on term storage pinned by the cache in bytes; shrinking evicts least recently used entries
+void setCapacityBytes(std::size_t bytes);
+
+// Current counters
+CacheStats stats();
+
+// Drop all cached results and reset the hit/miss/eviction counters
+void clear();
+
+} // namespace polynomialcache
+
+#endif